@@ -0,0 +1,97 @@
+#pragma once
+
+#include <eosio/crypto.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace eosio {
+
+/**
+ * Writes the decimal representation of `value` into `out`, two digits per step, and returns the number of characters
+ * written. The output is identical to `std::to_string(value)` without a terminating null, and `out` must have room for
+ * 20 characters.
+ */
+inline size_t write_decimal(uint64_t value, char* out)
+{
+   static constexpr char digit_pairs[] =
+      "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+      "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+   // Count the digits first so the number can be written backwards straight into `out`
+   size_t   length = 1;
+   uint64_t rest   = value;
+   while (rest >= 10000) {
+      rest /= 10000;
+      length += 4;
+   }
+   length += (rest >= 10) + (rest >= 100) + (rest >= 1000);
+
+   char* cursor = out + length;
+   while (value >= 100) {
+      const size_t pair = (value % 100) * 2;
+      value /= 100;
+      *--cursor = digit_pairs[pair + 1];
+      *--cursor = digit_pairs[pair];
+   }
+   if (value >= 10) {
+      *--cursor = digit_pairs[value * 2 + 1];
+      *--cursor = digit_pairs[value * 2];
+   } else {
+      *--cursor = '0' + value;
+   }
+
+   return length;
+}
+
+/**
+ * Hashes Droplet seeds against a single epoch seed.
+ *
+ * Produces the same hash as `dropssystem::epoch::hashdrop`, which is `sha256(hex(epoch_seed) + to_string(drop_seed))`,
+ * but encodes the epoch seed into a fixed buffer once and only writes the decimal Droplet seed in place for each
+ * Droplet, without any heap allocation.
+ */
+class drop_hasher
+{
+public:
+   explicit drop_hasher(const checksum256& epoch_seed)
+   {
+      static constexpr char hexmap[] = "0123456789abcdef";
+
+      const auto bytes = epoch_seed.extract_as_byte_array();
+      for (size_t i = 0; i < bytes.size(); ++i) {
+         buffer[2 * i]     = hexmap[(bytes[i] & 0xF0) >> 4];
+         buffer[2 * i + 1] = hexmap[bytes[i] & 0x0F];
+      }
+   }
+
+   checksum256 hash(const uint64_t drop_seed)
+   {
+      const size_t length = write_decimal(drop_seed, buffer + SEED_HEX_LENGTH);
+      return sha256(buffer, SEED_HEX_LENGTH + length);
+   }
+
+   /**
+    * Counts the leading zeros of the hex representation of `hash`, equivalent to `clzhex` on the hex string.
+    */
+   static uint16_t leading_zeros(const checksum256& hash)
+   {
+      const auto bytes = hash.extract_as_byte_array();
+      uint16_t   count = 0;
+      for (const uint8_t byte : bytes) {
+         if (byte != 0) {
+            return (byte & 0xF0) == 0 ? count + 1 : count;
+         }
+         count += 2;
+      }
+      return count;
+   }
+
+private:
+   static constexpr size_t SEED_HEX_LENGTH = 64;
+   static constexpr size_t MAX_DROP_DIGITS = 20; // digits in the largest uint64_t
+
+   char buffer[SEED_HEX_LENGTH + MAX_DROP_DIGITS];
+};
+
+} // namespace eosio
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <boost/pfr.hpp>
+#include <drops/drops.hpp>
+#include <eosio/check.hpp>
+#include <eosio/datastream.hpp>
+#include <eosio/name.hpp>
+#include <eosio/time.hpp>
+#include <eosio/varint.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace eosio {
+
+/**
+ * A non-owning view over a packed `vector<dropssystem::drops::drop_row>` inside action data.
+ *
+ * Constructing the view reads the row count and advances the datastream past the rows without decoding them, so the
+ * fields that follow can still be read from the same datastream. Each row field is decoded in place on demand, which
+ * lets notification handlers walk large Droplet lists without copying them onto the heap first.
+ */
+class drop_rows_view
+{
+public:
+   // Packed size of a `drop_row`: seed (8), owner (8), created (4) and bound (1), serialised back to back
+   static constexpr size_t ROW_SIZE = 21;
+
+   // The packed layout follows from the number, order and types of the `drop_row` fields, so fail the build if the
+   // vendored struct changes them after a `make drops/include` sync
+   using drop_row = dropssystem::drops::drop_row;
+   static_assert(boost::pfr::tuple_size_v<drop_row> == 4, "drop_rows_view expects drop_row to have 4 fields");
+   static_assert(std::is_same_v<boost::pfr::tuple_element_t<0, drop_row>, uint64_t>,
+                 "drop_rows_view expects drop_row::seed to be the first field, a uint64_t");
+   static_assert(std::is_same_v<boost::pfr::tuple_element_t<1, drop_row>, name>,
+                 "drop_rows_view expects drop_row::owner to be the second field, a name");
+   static_assert(std::is_same_v<boost::pfr::tuple_element_t<2, drop_row>, block_timestamp>,
+                 "drop_rows_view expects drop_row::created to be the third field, a block_timestamp");
+   static_assert(std::is_same_v<boost::pfr::tuple_element_t<3, drop_row>, bool>,
+                 "drop_rows_view expects drop_row::bound to be the last field, a bool");
+
+   class row
+   {
+   public:
+      explicit row(const char* data)
+         : data(data)
+      {
+      }
+
+      uint64_t        seed() const { return read<uint64_t>(0); }
+      name            owner() const { return name{read<uint64_t>(8)}; }
+      block_timestamp created() const { return block_timestamp{read<uint32_t>(16)}; }
+      bool            bound() const { return data[20] != 0; }
+
+   private:
+      template <typename T>
+      T read(const size_t offset) const
+      {
+         T value;
+         memcpy(&value, data + offset, sizeof(T));
+         return value;
+      }
+
+      const char* data;
+   };
+
+   class iterator
+   {
+   public:
+      explicit iterator(const char* data)
+         : data(data)
+      {
+      }
+
+      row       operator*() const { return row{data}; }
+      iterator& operator++()
+      {
+         data += ROW_SIZE;
+         return *this;
+      }
+      bool operator!=(const iterator& other) const { return data != other.data; }
+
+   private:
+      const char* data;
+   };
+
+   explicit drop_rows_view(datastream<const char*>& ds)
+   {
+      unsigned_int count;
+      ds >> count;
+      check(count.value <= ds.remaining() / ROW_SIZE, "drop_rows_view: packed rows exceed the action data");
+
+      rows = count.value;
+      data = ds.pos();
+      ds.skip(rows * ROW_SIZE);
+   }
+
+   size_t   size() const { return rows; }
+   bool     empty() const { return rows == 0; }
+   iterator begin() const { return iterator{data}; }
+   iterator end() const { return iterator{data + rows * ROW_SIZE}; }
+
+private:
+   const char* data = nullptr;
+   size_t      rows = 0;
+};
+
+} // namespace eosio
@@ -1,7 +1,12 @@
 #pragma once
 
 #include <eosio/asset.hpp>
+#include <eosio/binary_extension.hpp>
 #include <eosio/eosio.hpp>
+#include <eosio/singleton.hpp>
+#include <eosio.token/drop_hasher.hpp>
+#include <eosio.token/drop_rows_view.hpp>
+#include <eosio.token/pool_rewards.hpp>
 #include <epoch.drops/epoch.drops.hpp>
 
 #include <string>
@@ -51,6 +56,13 @@ public:
    // 2 difficulty = 16 * 16 = 1:256 odds
    const uint32_t SCRAP_MINING_DIFFICULTY = 2;
 
+   // The destroy memo that opts into minting only the qualifying Droplets instead of reverting on the first failure
+   const string SCRAP_PARTIAL_MINT_MEMO = "partial";
+
+   // The reasons a Droplet can be rejected during a partial mint
+   const uint8_t MINT_REJECTED_TOO_NEW    = 1; // created on or after the start of the current epoch
+   const uint8_t MINT_REJECTED_DIFFICULTY = 2; // hash does not meet the mining difficulty
+
    /**
     * Allows `issuer` account to create a token in supply of `maximum_supply`. If validation is successful a new
     * entry in statstable for token symbol scope gets created.
@@ -65,39 +77,121 @@ public:
     */
    [[eosio::action]] void create(const name& issuer, const asset& maximum_supply);
 
+   /**
+    * A struct that represents the computed result of the hashing that took place during the minting process.
+    */
+   struct mint_result
+   {
+      uint64_t    seed;
+      checksum256 hash;
+   };
+
+   /**
+    * A struct that represents a Droplet that was destroyed but not minted during a partial mint.
+    */
+   struct mint_rejection
+   {
+      uint64_t seed;
+      uint8_t  reason;
+   };
+
+   /**
+    * A struct that represents the compact result of a mint, returned by the mint notification handler. The minted
+    * Droplets are the destroyed Droplets that were not rejected, and the rejected Droplets with their reasons are
+    * only listed by `logmint`.
+    *
+    * CDT does not add `action_results` entries for notification handlers, so this type is not in the ABI. The return
+    * value of the `drops::logdestroy` notification trace on this contract is packed as:
+    *
+    * - `minted` - asset: int64 amount, then uint64 symbol (`0 SCRAP`)
+    * - `epoch` - uint64
+    * - `rejected` - uint32 number of Droplets rejected during a partial mint
+    *
+    * All integers are little-endian, matching the `mint_receipt` ABI struct:
+    *
+    * ```json
+    * {"name": "mint_receipt", "base": "", "fields": [
+    *   {"name": "minted", "type": "asset"},
+    *   {"name": "epoch", "type": "uint64"},
+    *   {"name": "rejected", "type": "uint32"}
+    * ]}
+    * ```
+    *
+    * The receipt is always 28 bytes however many Droplets are destroyed, within the 256 byte default
+    * `max_action_return_value_size` of the chain.
+    */
+   struct mint_receipt
+   {
+      asset    minted;
+      uint64_t epoch;
+      uint32_t rejected;
+   };
+
    /**
     * This action mint new tokens to the `owner` account, provided the `droplet_ids` destroyed are valid and `memo` meet
     * the criteria of minting.
     *
-    * @param owner - the account that creates the token,
-    * @param drops - the maximum supply set for the token created.
-    * @param memo - the memo string to accompany the transaction.
+    * When the destroy `memo` is `SCRAP_PARTIAL_MINT_MEMO`, Droplets that are too new or do not meet the difficulty are
+    * reported as rejected in `logmint` instead of reverting the destroy, and only the qualifying Droplets are minted.
+    *
+    * The mint always returns a compact `mint_receipt` as the notification's action return value. The full
+    * `logmint` inline action is only sent while it is enabled through `setlogmint`, which is the default.
+    *
+    * The `drops::logdestroy` notification data (owner, droplet_ids, destroyed, unbound_destroyed, bytes_reclaimed,
+    * memo, to_notify) is read in place from the action datastream rather than deserialised into parameters, so the
+    * destroyed Droplet rows are never copied.
     */
-   [[eosio::on_notify("drops::logdestroy")]] void mint(const name                                 owner,
-                                                       const vector<dropssystem::drops::drop_row> droplet_ids,
-                                                       const int64_t                              destroyed,
-                                                       const int64_t                              unbound_destroyed,
-                                                       const int64_t                              bytes_reclaimed,
-                                                       optional<string>                           memo,
-                                                       optional<name>                             to_notify);
+   [[eosio::on_notify("drops::logdestroy")]] mint_receipt mint();
 
    /**
-    * A struct that represents the computed result of the hashing that took place during the minting process.
+    * Enables or disables sending the `logmint` inline action at the end of each mint. When disabled, the mint result
+    * is only available as the return value of the mint notification handler.
+    *
+    * @param enabled - whether `logmint` is sent.
     */
-   struct mint_result
+   [[eosio::action]] void setlogmint(const bool enabled);
+
+   /**
+    * This action logs the minting of tokens to the `owner` account, along with any Droplets rejected during a
+    * partial mint. `rejected` is a binary extension so that `logmint` traces recorded before it existed still decode.
+    */
+   [[eosio::action]] void logmint(const name                                     owner,
+                                  const asset                                    minted,
+                                  const uint64_t                                 epoch,
+                                  const checksum256                              hash,
+                                  const vector<mint_result>                      results,
+                                  const binary_extension<vector<mint_rejection>> rejected);
+
+   // The most Droplets a single mint preview accepts. The packed `mint_preview` is 16 bytes of asset, a 2 byte
+   // varuint32 count and 1 byte per Droplet, so 200 Droplets keep it at 218 bytes, under the 256 byte default
+   // `max_action_return_value_size` of the chain.
+   const uint32_t MINT_PREVIEW_MAX_SEEDS = 200;
+
+   /**
+    * A struct that represents the outcome of a mint preview.
+    */
+   struct mint_preview
    {
-      uint64_t    seed;
-      checksum256 hash;
+      asset           minted;
+      vector<uint8_t> passed; // 1 if the Droplet at the same index would mint, 0 otherwise
    };
 
    /**
-    * This action logs the minting of tokens to the `owner` account.
+    * This read-only action previews a mint for the `owner` account without destroying any Droplets, using the same
+    * epoch, hashing, difficulty and mint amount rules as the mint process.
+    *
+    * Action return values are limited to 256 bytes by default (`max_action_return_value_size`), so the preview only
+    * reports whether each Droplet would pass and accepts at most `MINT_PREVIEW_MAX_SEEDS` Droplets per call. The
+    * hashes can be recomputed off-chain from the revealed epoch seed.
+    *
+    * @param owner - the account that would receive the minted tokens,
+    * @param seeds - the seeds of the Droplets to be destroyed, at most `MINT_PREVIEW_MAX_SEEDS`,
+    * @param created - the creation time of each Droplet, in the same order as `seeds`.
+    *
+    * @return the total amount that would be minted, and whether each Droplet would pass in the order of `seeds`.
     */
-   [[eosio::action]] void logmint(const name                owner,
-                                  const asset               minted,
-                                  const uint64_t            epoch,
-                                  const checksum256         hash,
-                                  const vector<mint_result> results);
+   [[eosio::action, eosio::read_only]] mint_preview
+   mintpreview(const name owner, const vector<uint64_t> seeds, const vector<block_timestamp> created);
 
    /**
     *  This action issues to `to` account a `quantity` of tokens.
@@ -152,6 +246,46 @@ public:
     */
    [[eosio::action]] void close(const name& owner, const symbol& symbol);
 
+   /**
+    * Registers the `pool` account as a mining pool. SCRAP minted to a pool with members is held as unclaimed on the
+    * pool row and accrues to the members in proportion to their shares, instead of being credited to the pool
+    * account.
+    *
+    * @param pool - the mining pool account, which pays for the RAM of the pool and its members.
+    */
+   [[eosio::action]] void poolopen(const name pool);
+
+   /**
+    * Closes `pool` once it has no members left. Any SCRAP left unclaimed by the pool, such as rounding dust, is
+    * credited to the pool account.
+    *
+    * @param pool - the mining pool account.
+    *
+    * @pre All members must have been set to zero shares and have claimed their rewards.
+    */
+   [[eosio::action]] void poolclose(const name pool);
+
+   /**
+    * Sets the `shares` of `member` in `pool`. Rewards accrued under the previous shares are kept for the member to
+    * claim. A member set to no shares with less than one SCRAP left to claim is removed, and that fraction stays
+    * unclaimed on the pool.
+    *
+    * @param pool - the mining pool account,
+    * @param member - the account participating in the pool,
+    * @param shares - the new amount of shares held by `member`.
+    */
+   [[eosio::action]] void poolshares(const name pool, const name member, const uint64_t shares);
+
+   /**
+    * Claims the SCRAP accrued to `member` in `pool` into their balance.
+    *
+    * @param pool - the mining pool account,
+    * @param member - the account claiming its accrued rewards.
+    *
+    * @return the amount of SCRAP claimed.
+    */
+   [[eosio::action]] asset poolclaim(const name pool, const name member);
+
 #ifdef DEBUG
    /**
     * FOR DEBUGGING: This action will destroy all balances and reset the contract.
@@ -181,6 +315,13 @@ public:
    using close_action    = eosio::action_wrapper<"close"_n, &token::close>;
    using logmint_action  = eosio::action_wrapper<"logmint"_n, &token::logmint>;
 
+   using mintpreview_action = eosio::action_wrapper<"mintpreview"_n, &token::mintpreview>;
+   using setlogmint_action  = eosio::action_wrapper<"setlogmint"_n, &token::setlogmint>;
+   using poolopen_action    = eosio::action_wrapper<"poolopen"_n, &token::poolopen>;
+   using poolclose_action   = eosio::action_wrapper<"poolclose"_n, &token::poolclose>;
+   using poolshares_action  = eosio::action_wrapper<"poolshares"_n, &token::poolshares>;
+   using poolclaim_action   = eosio::action_wrapper<"poolclaim"_n, &token::poolclaim>;
+
 private:
    struct [[eosio::table]] account
    {
@@ -198,12 +339,53 @@ private:
       uint64_t primary_key() const { return supply.symbol.code().raw(); }
    };
 
+   struct [[eosio::table("config")]] config_row
+   {
+      bool logmint = true; // send the logmint inline action on each mint
+   };
+
+   struct [[eosio::table("pool")]] pool_row
+   {
+      name      pool;
+      uint64_t  total_shares;
+      uint128_t reward_per_share; // cumulative SCRAP units per share, scaled by POOL_PRECISION
+      uint128_t remainder;        // scaled units left over from rounding, carried into the next mint
+      asset     unclaimed;        // SCRAP minted to the pool and not yet claimed by its members
+
+      uint64_t primary_key() const { return pool.value; }
+   };
+
+   struct [[eosio::table("member")]] member_row
+   {
+      name      member;
+      uint64_t  shares;
+      uint128_t reward_debt; // shares * reward_per_share when last settled, scaled by POOL_PRECISION
+      uint128_t owed;        // settled rewards not yet claimed, scaled by POOL_PRECISION
+
+      uint64_t primary_key() const { return member.value; }
+   };
+
    typedef eosio::multi_index<"accounts"_n, account>    accounts;
    typedef eosio::multi_index<"stat"_n, currency_stats> stats;
+   typedef eosio::singleton<"config"_n, config_row>     config_table;
+   typedef eosio::multi_index<"pool"_n, pool_row>       pools;
+   typedef eosio::multi_index<"member"_n, member_row>   members;
+
+   /**
+    * The revealed epoch that Droplets are currently minted against.
+    */
+   struct mint_epoch
+   {
+      uint64_t        epoch;
+      checksum256     seed;
+      block_timestamp valid_before;
+   };
 
-   void     sub_balance(const name& owner, const asset& value);
-   void     add_balance(const name& owner, const asset& value, const name& ram_payer);
-   uint64_t get_mint_amount(const uint64_t current_supply);
+   void       sub_balance(const name& owner, const asset& value);
+   void       add_balance(const name& owner, const asset& value, const name& ram_payer);
+   uint64_t   get_mint_amount(const uint64_t current_supply);
+   mint_epoch get_mint_epoch();
+   bool       credit_pool(const name& pool, const asset& quantity);
 };
 
 } // namespace eosio
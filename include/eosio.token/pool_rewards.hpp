@@ -0,0 +1,113 @@
+#pragma once
+
+#include <eosio/types.h>
+
+#include <cstdint>
+
+namespace eosio {
+
+/**
+ * Reward-per-share accounting for mining pools.
+ *
+ * SCRAP has no decimals, so the accumulator is kept in units scaled by `POOL_PRECISION`. Minted rewards never exceed
+ * the 1000 million SCRAP of the final mining era, and a pool has at least one share when it is credited, so
+ * `reward_per_share` stays below 1e9 * POOL_PRECISION = 1e23. With at most `POOL_MAX_SHARES` shares, every
+ * `shares * reward_per_share` product stays below 1e37, well within 128 bits, so none of this arithmetic wraps.
+ */
+
+// Scale of the reward per share accumulator. It is at least `POOL_MAX_SHARES`, so even the smallest reward always
+// advances the accumulator instead of waiting in the remainder.
+static constexpr uint128_t POOL_PRECISION = 100'000'000'000'000;
+
+// Upper bound on the total shares of a pool
+static constexpr uint64_t POOL_MAX_SHARES = 100'000'000'000'000;
+
+/**
+ * Spreads `amount` SCRAP units over `total_shares`, carrying the rounding remainder into the next call.
+ */
+inline void accrue_pool_reward(uint128_t&     reward_per_share,
+                               uint128_t&     remainder,
+                               const uint64_t total_shares,
+                               const uint64_t amount)
+{
+   const uint128_t scaled = uint128_t(amount) * POOL_PRECISION + remainder;
+
+   reward_per_share += scaled / total_shares;
+   remainder         = scaled % total_shares;
+}
+
+/**
+ * The accounting state of a pool member, mirroring the fields of the contract's member rows.
+ */
+struct pool_member
+{
+   uint64_t  shares      = 0;
+   uint128_t reward_debt = 0;
+   uint128_t owed        = 0;
+};
+
+/**
+ * The member state after a share change, and whether the member row should be removed.
+ */
+struct pool_settlement
+{
+   pool_member member;
+   bool        remove = false;
+};
+
+/**
+ * The member state after a claim, the whole SCRAP units claimed, and whether the member row should be removed.
+ */
+struct pool_claim
+{
+   pool_member member;
+   uint64_t    claimed = 0;
+   bool        remove  = false;
+};
+
+/**
+ * The scaled rewards owed to `member` since its `reward_debt` was last set to `shares * reward_per_share`.
+ * The accumulator only grows, so the subtraction cannot underflow.
+ */
+inline uint128_t get_pool_owed(const pool_member& member, const uint128_t reward_per_share)
+{
+   return member.owed + uint128_t(member.shares) * reward_per_share - member.reward_debt;
+}
+
+/**
+ * Settles everything `member` accrued under its current shares and moves it to `shares`.
+ *
+ * A member left without shares and with less than one SCRAP to claim is removed, its fraction stays unclaimed on the
+ * pool.
+ */
+inline pool_settlement settle_pool_member(const pool_member& member,
+                                          const uint128_t    reward_per_share,
+                                          const uint64_t     shares)
+{
+   pool_settlement result;
+   result.member.shares      = shares;
+   result.member.reward_debt = uint128_t(shares) * reward_per_share;
+   result.member.owed        = get_pool_owed(member, reward_per_share);
+   result.remove             = shares == 0 && result.member.owed < POOL_PRECISION;
+   return result;
+}
+
+/**
+ * Claims the whole SCRAP units owed to `member`, the fraction stays owed to the member.
+ *
+ * A member without shares has nothing left to accrue and is removed, its fraction stays unclaimed on the pool.
+ */
+inline pool_claim claim_pool_member(const pool_member& member, const uint128_t reward_per_share)
+{
+   const uint128_t owed = get_pool_owed(member, reward_per_share);
+
+   pool_claim result;
+   result.member.shares      = member.shares;
+   result.member.reward_debt = uint128_t(member.shares) * reward_per_share;
+   result.member.owed        = owed % POOL_PRECISION;
+   result.claimed            = static_cast<uint64_t>(owed / POOL_PRECISION);
+   result.remove             = member.shares == 0;
+   return result;
+}
+
+} // namespace eosio
@@ -44,31 +44,24 @@ void token::destroy(const name& issuer, const asset& maximum_supply)
 }
 #endif
 
-[[eosio::on_notify("drops::logdestroy")]] void token::mint(const name                                 owner,
-                                                           const vector<dropssystem::drops::drop_row> droplet_ids,
-                                                           const int64_t                              destroyed,
-                                                           const int64_t                              unbound_destroyed,
-                                                           const int64_t                              bytes_reclaimed,
-                                                           optional<string>                           memo,
-                                                           optional<name>                             to_notify)
+[[eosio::on_notify("drops::logdestroy")]] token::mint_receipt token::mint()
 {
-   const dropssystem::epoch::epoch_table _epoch("epoch.drops"_n, "epoch.drops"_n.value);
-   dropssystem::epoch::state_table       _state("epoch.drops"_n, "epoch.drops"_n.value);
-
-   // Retrieve the current epoch being used (current - 1)
-   auto     state          = _state.get();
-   uint64_t epoch_height   = dropssystem::epoch::derive_epoch(state.genesis, state.duration);
-   uint64_t epoch_previous = epoch_height - 1;
-
-   // Derive the start time of current epoch, all destroyed Droplets must have been created before this
-   const block_timestamp valid_before =
-      dropssystem::epoch::derive_epoch_start(state.genesis, state.duration, epoch_height);
-
-   // Load the usable/previous epoch from the table
-   auto epoch = _epoch.find(epoch_previous);
-
-   // Ensure the current epoch has been revealed
-   check(epoch->seed != checksum256{}, "Waiting for the previous epoch to be revealed by oracles.");
+   // Read the owner and the destroyed Droplet(s) in place from the logdestroy action data
+   auto& ds = get_datastream();
+   name  owner;
+   ds >> owner;
+   const drop_rows_view droplets(ds);
+
+   // Read the remaining logdestroy fields, the memo selects whether non-qualifying Droplet(s) revert the mint
+   int64_t          destroyed;
+   int64_t          unbound_destroyed;
+   int64_t          bytes_reclaimed;
+   optional<string> memo;
+   ds >> destroyed >> unbound_destroyed >> bytes_reclaimed >> memo;
+   const bool partial = memo && *memo == SCRAP_PARTIAL_MINT_MEMO;
+
+   // Retrieve the usable epoch (current - 1) and ensure it has been revealed
+   const mint_epoch epoch = get_mint_epoch();
 
    // The current token supply
    stats statstable(get_self(), SCRAP_SYMBOL.code().raw());
@@ -82,32 +75,66 @@ void token::destroy(const name& issuer, const asset& maximum_supply)
    // The amount of SCRAP to for the given Droplet(s) destroyed (in units)
    uint64_t amount = 0;
 
-   // The result of the mint process
+   // Whether the full result is logged through the logmint inline action
+   config_table _config(get_self(), get_self().value);
+   const bool   log_results = _config.get_or_default().logmint;
+
+   // The result of the mint process, sized once from the destroyed Droplet(s)
    vector<mint_result> results;
+   if (log_results) {
+      results.reserve(droplets.size());
+   }
+
+   // The Droplet(s) skipped during a partial mint, only listed when logged through logmint
+   vector<mint_rejection> rejected;
+   uint32_t               rejected_count = 0;
+
+   // Hashes each Droplet seed against the previous epoch revealed seed
+   drop_hasher hasher(epoch.seed);
 
    // Compute the hash for the provided Droplet(s) using the previous epoch revealed seed
-   for (auto itr = begin(droplet_ids); itr != end(droplet_ids); ++itr) {
-      check(itr->created < valid_before,
-            "An included Drop was created (" + std::to_string(itr->created.to_time_point().sec_since_epoch()) +
-               ") after the start (" + std::to_string(valid_before.to_time_point().sec_since_epoch()) +
-               ") of the valid epoch (" + std::to_string(epoch_previous) + ").");
+   for (const auto droplet : droplets) {
+      const uint64_t        seed    = droplet.seed();
+      const block_timestamp created = droplet.created();
+
+      if (created >= epoch.valid_before) {
+         if (partial) {
+            if (log_results) {
+               rejected.push_back(mint_rejection{seed, MINT_REJECTED_TOO_NEW});
+            }
+            ++rejected_count;
+            continue;
+         }
+         check(false, "An included Drop was created (" + std::to_string(created.to_time_point().sec_since_epoch()) +
+                         ") after the start (" +
+                         std::to_string(epoch.valid_before.to_time_point().sec_since_epoch()) +
+                         ") of the valid epoch (" + std::to_string(epoch.epoch) + ").");
+      }
 
       // Combine epoch seed value and Droplet seed value to create a unique hash
-      const checksum256 hash = dropssystem::epoch::hashdrop(epoch->seed, itr->seed);
+      const checksum256 hash = hasher.hash(seed);
 
-      // Convert to a hex value and count the leading zeros
-      auto   hash_array  = hash.extract_as_byte_array();
-      string hash_result = dropssystem::epoch::hex_to_str(hash_array.data(), hash_array.size());
-      auto   zeros       = dropssystem::epoch::clzhex(hash_result);
+      // Count the leading zeros of the hex value
+      const uint16_t zeros = drop_hasher::leading_zeros(hash);
 
       // Ensure the leading zeros meet the difficulty requirement
-      check(zeros >= SCRAP_MINING_DIFFICULTY,
-            "Hash (" + hash_result + ") for provided Droplet (" + std::to_string(itr->seed) +
-               ")  does not meet the difficulty requirement of " + std::to_string(SCRAP_MINING_DIFFICULTY) + " (" +
-               std::to_string(zeros) + ").");
+      if (zeros < SCRAP_MINING_DIFFICULTY) {
+         if (partial) {
+            if (log_results) {
+               rejected.push_back(mint_rejection{seed, MINT_REJECTED_DIFFICULTY});
+            }
+            ++rejected_count;
+            continue;
+         }
+         check(false, "Hash (" + dropssystem::epoch::checksum256_to_string(hash) + ") for provided Droplet (" +
+                         std::to_string(seed) + ")  does not meet the difficulty requirement of " +
+                         std::to_string(SCRAP_MINING_DIFFICULTY) + " (" + std::to_string(zeros) + ").");
+      }
 
       // Save a reciept of this Drop being minted into SCRAP
-      results.push_back(mint_result{itr->seed, hash});
+      if (log_results) {
+         results.push_back(mint_result{seed, hash});
+      }
 
       // The amount of SCRAP to receive for this Droplet
       const uint64_t mint_amount = get_mint_amount(current_supply);
@@ -120,12 +147,98 @@ void token::destroy(const name& issuer, const asset& maximum_supply)
    }
 
    asset quantity = asset(amount, SCRAP_SYMBOL);
-   statstable.modify(st, get_self(), [&](auto& s) { s.supply += quantity; });
 
-   add_balance(owner, quantity, get_self());
+   // Nothing is minted when every Droplet was rejected or the maximum supply is reached
+   if (quantity.amount > 0) {
+      statstable.modify(st, get_self(), [&](auto& s) { s.supply += quantity; });
+
+      // Mining pools accrue the minted SCRAP to their members, everyone else receives it directly
+      if (!credit_pool(owner, quantity)) {
+         add_balance(owner, quantity, get_self());
+      }
+   }
+
+   if (log_results) {
+      token::logmint_action logmint{get_self(), {get_self(), "active"_n}};
+      logmint.send(
+         owner, quantity, epoch.epoch, epoch.seed, results, binary_extension<vector<mint_rejection>>{rejected});
+   }
+
+   return mint_receipt{quantity, epoch.epoch, rejected_count};
+}
+
+[[eosio::action]] void token::setlogmint(const bool enabled)
+{
+   require_auth(get_self());
+
+   config_table _config(get_self(), get_self().value);
+   auto         config = _config.get_or_default();
+   config.logmint      = enabled;
+   _config.set(config, get_self());
+}
+
+[[eosio::action, eosio::read_only]] token::mint_preview
+token::mintpreview(const name owner, const vector<uint64_t> seeds, const vector<block_timestamp> created)
+{
+   check(seeds.size() == created.size(), "seeds and created must be the same length");
+   check(seeds.size() <= MINT_PREVIEW_MAX_SEEDS, "too many seeds, a mint preview accepts at most 200 Droplets");
+
+   // Retrieve the usable epoch (current - 1) and ensure it has been revealed
+   const mint_epoch epoch = get_mint_epoch();
+
+   // The current token supply
+   stats       statstable(get_self(), SCRAP_SYMBOL.code().raw());
+   const auto& st = statstable.get(SCRAP_SYMBOL.code().raw(), "token with symbol does not exist");
+
+   // Running total of the supply as it would increase during a mint
+   uint64_t current_supply = st.supply.amount;
+
+   // The amount of SCRAP the qualifying Droplet(s) would mint (in units)
+   uint64_t amount = 0;
+
+   vector<uint8_t> passed;
+   passed.reserve(seeds.size());
+
+   drop_hasher hasher(epoch.seed);
+
+   for (size_t i = 0; i < seeds.size(); ++i) {
+      // Apply the same creation time and difficulty rules as the mint process
+      const bool qualifies = created[i] < epoch.valid_before &&
+                             drop_hasher::leading_zeros(hasher.hash(seeds[i])) >= SCRAP_MINING_DIFFICULTY;
+
+      passed.push_back(qualifies);
+
+      if (qualifies) {
+         const uint64_t mint_amount = get_mint_amount(current_supply);
+         amount += mint_amount;
+         current_supply += mint_amount;
+      }
+   }
+
+   return mint_preview{asset(amount, SCRAP_SYMBOL), passed};
+}
+
+token::mint_epoch token::get_mint_epoch()
+{
+   const dropssystem::epoch::epoch_table _epoch("epoch.drops"_n, "epoch.drops"_n.value);
+   dropssystem::epoch::state_table       _state("epoch.drops"_n, "epoch.drops"_n.value);
+
+   // Retrieve the current epoch being used (current - 1)
+   auto     state          = _state.get();
+   uint64_t epoch_height   = dropssystem::epoch::derive_epoch(state.genesis, state.duration);
+   uint64_t epoch_previous = epoch_height - 1;
+
+   // Derive the start time of current epoch, all destroyed Droplets must have been created before this
+   const block_timestamp valid_before =
+      dropssystem::epoch::derive_epoch_start(state.genesis, state.duration, epoch_height);
+
+   // Load the usable/previous epoch from the table
+   const auto& epoch = _epoch.get(epoch_previous, "The previous epoch does not exist.");
+
+   // Ensure the current epoch has been revealed
+   check(epoch.seed != checksum256{}, "Waiting for the previous epoch to be revealed by oracles.");
 
-   token::logmint_action logmint{get_self(), {get_self(), "active"_n}};
-   logmint.send(owner, quantity, epoch_previous, epoch->seed, results);
+   return mint_epoch{epoch_previous, epoch.seed, valid_before};
 }
 
 uint64_t token::get_mint_amount(const uint64_t current_supply)
@@ -159,8 +272,12 @@ uint64_t token::get_mint_amount(const uint64_t current_supply)
    }
 }
 
-[[eosio::action]] void token::logmint(
-   const name owner, const asset minted, const uint64_t epoch, const checksum256 seed, vector<mint_result> result)
+[[eosio::action]] void token::logmint(const name                                     owner,
+                                     const asset                                    minted,
+                                     const uint64_t                                 epoch,
+                                     const checksum256                              seed,
+                                     const vector<mint_result>                      result,
+                                     const binary_extension<vector<mint_rejection>> rejected)
 {
    require_auth(get_self());
    if (owner != get_self()) {
@@ -286,4 +403,129 @@ void token::close(const name& owner, const symbol& symbol)
    acnts.erase(it);
 }
 
+void token::poolopen(const name pool)
+{
+   require_auth(pool);
+
+   pools pooltable(get_self(), get_self().value);
+   check(pooltable.find(pool.value) == pooltable.end(), "pool already exists");
+
+   pooltable.emplace(pool, [&](auto& p) {
+      p.pool             = pool;
+      p.total_shares     = 0;
+      p.reward_per_share = 0;
+      p.remainder        = 0;
+      p.unclaimed        = asset(0, SCRAP_SYMBOL);
+   });
+}
+
+void token::poolclose(const name pool)
+{
+   require_auth(pool);
+
+   pools       pooltable(get_self(), get_self().value);
+   const auto& p = pooltable.get(pool.value, "pool does not exist");
+
+   members memberstable(get_self(), pool.value);
+   check(memberstable.begin() == memberstable.end(), "pool still has members");
+
+   // Whatever members can no longer claim, such as rounding dust, returns to the pool account
+   if (p.unclaimed.amount > 0) {
+      add_balance(pool, p.unclaimed, pool);
+   }
+
+   pooltable.erase(p);
+}
+
+void token::poolshares(const name pool, const name member, const uint64_t shares)
+{
+   require_auth(pool);
+   check(is_account(member), "member account does not exist");
+
+   pools       pooltable(get_self(), get_self().value);
+   const auto& p = pooltable.get(pool.value, "pool does not exist");
+
+   members memberstable(get_self(), pool.value);
+   auto    existing = memberstable.find(member.value);
+
+   const uint64_t previous_shares = existing == memberstable.end() ? 0 : existing->shares;
+   check(shares <= POOL_MAX_SHARES - (p.total_shares - previous_shares), "pool shares exceed the maximum");
+
+   pooltable.modify(p, same_payer, [&](auto& row) { row.total_shares = row.total_shares - previous_shares + shares; });
+
+   // Settle everything accrued under the previous shares before they change
+   pool_member current;
+   if (existing != memberstable.end()) {
+      current = pool_member{existing->shares, existing->reward_debt, existing->owed};
+   }
+   const pool_settlement settled = settle_pool_member(current, p.reward_per_share, shares);
+
+   if (existing == memberstable.end()) {
+      if (!settled.remove) {
+         memberstable.emplace(pool, [&](auto& m) {
+            m.member      = member;
+            m.shares      = settled.member.shares;
+            m.reward_debt = settled.member.reward_debt;
+            m.owed        = settled.member.owed;
+         });
+      }
+   } else if (settled.remove) {
+      memberstable.erase(existing);
+   } else {
+      memberstable.modify(existing, same_payer, [&](auto& m) {
+         m.shares      = settled.member.shares;
+         m.reward_debt = settled.member.reward_debt;
+         m.owed        = settled.member.owed;
+      });
+   }
+}
+
+asset token::poolclaim(const name pool, const name member)
+{
+   require_auth(member);
+
+   pools       pooltable(get_self(), get_self().value);
+   const auto& p = pooltable.get(pool.value, "pool does not exist");
+
+   members     memberstable(get_self(), pool.value);
+   const auto& m = memberstable.get(member.value, "account is not a member of this pool");
+
+   const pool_claim result  = claim_pool_member(pool_member{m.shares, m.reward_debt, m.owed}, p.reward_per_share);
+   const asset      claimed = asset(static_cast<int64_t>(result.claimed), SCRAP_SYMBOL);
+   check(claimed <= p.unclaimed, "claim exceeds the unclaimed rewards of the pool");
+
+   if (result.remove) {
+      memberstable.erase(m);
+   } else {
+      memberstable.modify(m, same_payer, [&](auto& row) {
+         row.reward_debt = result.member.reward_debt;
+         row.owed        = result.member.owed;
+      });
+   }
+
+   if (claimed.amount > 0) {
+      pooltable.modify(p, same_payer, [&](auto& row) { row.unclaimed -= claimed; });
+      add_balance(member, claimed, member);
+   }
+
+   return claimed;
+}
+
+bool token::credit_pool(const name& pool, const asset& quantity)
+{
+   pools pooltable(get_self(), get_self().value);
+   auto  p = pooltable.find(pool.value);
+   if (p == pooltable.end() || p->total_shares == 0) {
+      return false;
+   }
+
+   // Bump the reward per share once and hold the SCRAP on the pool, members claim their share of it lazily
+   pooltable.modify(p, same_payer, [&](auto& row) {
+      accrue_pool_reward(row.reward_per_share, row.remainder, row.total_shares, quantity.amount);
+      row.unclaimed += quantity;
+   });
+
+   return true;
+}
+
 } // namespace eosio
@@ -0,0 +1,89 @@
+#include <eosio.token/drop_hasher.hpp>
+
+#include <string>
+
+#include "test.hpp"
+
+using namespace eosio;
+
+// Any difference from `std::to_string` or from `hex(epoch_seed) + to_string(drop_seed)` would change Droplet hashes
+// and therefore which Droplets can be minted, so these checks must stay exact.
+
+static void check_decimal(const uint64_t value)
+{
+   char         out[20];
+   const size_t length = write_decimal(value, out);
+   test::expect(std::string(out, length) == std::to_string(value), "write_decimal", value);
+}
+
+static std::string to_hex(const checksum256& checksum)
+{
+   static constexpr char hexmap[] = "0123456789abcdef";
+   std::string           hex;
+   for (const uint8_t byte : checksum.bytes) {
+      hex += hexmap[byte >> 4];
+      hex += hexmap[byte & 0x0F];
+   }
+   return hex;
+}
+
+int main()
+{
+   auto random = test::make_random();
+
+   // Every value up to a few million, covering every length up to 7 digits
+   for (uint64_t value = 0; value < 3'000'000; ++value) {
+      check_decimal(value);
+   }
+
+   // Powers of ten and two, and their neighbours, where the digit count changes
+   uint64_t power = 1;
+   for (int i = 0; i < 20; ++i, power *= 10) {
+      check_decimal(power - 1);
+      check_decimal(power);
+      check_decimal(power + 1);
+   }
+   for (int shift = 0; shift < 64; ++shift) {
+      check_decimal((uint64_t{1} << shift) - 1);
+      check_decimal(uint64_t{1} << shift);
+      check_decimal((uint64_t{1} << shift) + 1);
+   }
+   check_decimal(UINT64_MAX - 1);
+   check_decimal(UINT64_MAX);
+
+   // Random values across every magnitude
+   for (int i = 0; i < 20'000'000; ++i) {
+      check_decimal(random() >> (random() % 64));
+   }
+
+   // The hashed input is the hex epoch seed followed by the decimal Droplet seed
+   checksum256 epoch_seed;
+   for (auto& byte : epoch_seed.bytes) {
+      byte = static_cast<uint8_t>(random());
+   }
+   drop_hasher       hasher(epoch_seed);
+   const std::string seed_hex = to_hex(epoch_seed);
+   for (int i = 0; i < 100'000; ++i) {
+      const uint64_t drop_seed = i == 0 ? UINT64_MAX : random() >> (random() % 64);
+      hasher.hash(drop_seed);
+      test::expect(last_sha256_input == seed_hex + std::to_string(drop_seed), "drop_hasher::hash", drop_seed);
+   }
+
+   // Leading zeros match counting '0' characters at the start of the hex string
+   for (int i = 0; i < 100'000; ++i) {
+      checksum256 hash;
+      for (auto& byte : hash.bytes) {
+         byte = static_cast<uint8_t>(random());
+      }
+      const size_t zeros = random() % 65;
+      for (size_t nibble = 0; nibble < zeros; ++nibble) {
+         hash.bytes[nibble / 2] &= nibble % 2 == 0 ? 0x0F : 0xF0;
+      }
+      const std::string hex      = to_hex(hash);
+      const size_t      nonzero  = hex.find_first_not_of('0');
+      const size_t      expected = nonzero == std::string::npos ? hex.size() : nonzero;
+      test::expect(drop_hasher::leading_zeros(hash) == expected, "drop_hasher::leading_zeros", zeros);
+   }
+
+   return test::finish("drop_hasher");
+}
@@ -0,0 +1,152 @@
+#include "test.hpp"
+
+#include <eosio.token/pool_rewards.hpp>
+
+#include <map>
+
+using namespace eosio;
+using test::expect;
+
+// SCRAP has zero precision, so every SCRAP unit minted to a pool must be accounted for exactly: claimed by a member,
+// still owed to a member, carried in the pool remainder, or left unclaimed on the pool as sub-unit dust.
+
+// Mirrors the pool and member rows kept by the token contract, and applies the same helpers as its pool actions
+struct pool
+{
+   uint64_t                        total_shares     = 0;
+   uint128_t                       reward_per_share = 0;
+   uint128_t                       remainder        = 0;
+   uint64_t                        unclaimed        = 0;
+   std::map<uint64_t, pool_member> members;
+   uint128_t                       dust = 0; // scaled rewards left behind by removed members
+
+   void credit(const uint64_t amount)
+   {
+      accrue_pool_reward(reward_per_share, remainder, total_shares, amount);
+      unclaimed += amount;
+   }
+
+   void set_shares(const uint64_t account, const uint64_t shares)
+   {
+      auto              existing = members.find(account);
+      const pool_member current  = existing == members.end() ? pool_member{} : existing->second;
+      total_shares               = total_shares - current.shares + shares;
+
+      const pool_settlement settled = settle_pool_member(current, reward_per_share, shares);
+      if (settled.remove) {
+         dust += settled.member.owed;
+         members.erase(account);
+      } else {
+         members[account] = settled.member;
+      }
+   }
+
+   uint64_t claim(const uint64_t account)
+   {
+      auto             existing = members.find(account);
+      const pool_claim result   = claim_pool_member(existing->second, reward_per_share);
+      expect(result.claimed <= unclaimed, "claim exceeds the unclaimed rewards of the pool");
+      if (result.remove) {
+         dust += result.member.owed;
+         members.erase(existing);
+      } else {
+         existing->second = result.member;
+      }
+      unclaimed -= result.claimed;
+      return result.claimed;
+   }
+
+   bool conserved() const
+   {
+      uint128_t total = remainder + dust;
+      for (const auto& [account, m] : members) {
+         total += get_pool_owed(m, reward_per_share);
+      }
+      return total == uint128_t(unclaimed) * POOL_PRECISION;
+   }
+};
+
+int main()
+{
+   // The smallest reward always advances the accumulator, even with the maximum number of shares
+   {
+      pool p;
+      p.set_shares(1, POOL_MAX_SHARES);
+      p.credit(1);
+      expect(p.reward_per_share > 0, "a 1 SCRAP reward is held back in the remainder");
+      expect(p.conserved(), "single unit reward is not conserved");
+   }
+
+   // A lone share receiving every SCRAP that can be mined, then raised to the maximum shares, stays within 128 bits
+   {
+      pool p;
+      p.set_shares(1, 1);
+      p.credit(1'000'000'000);
+      p.set_shares(1, POOL_MAX_SHARES);
+      p.credit(8);
+      const uint128_t product = uint128_t(POOL_MAX_SHARES) * p.reward_per_share;
+      expect(product / POOL_MAX_SHARES == p.reward_per_share, "shares * reward_per_share overflows");
+      expect(p.claim(1) == 1'000'000'008, "the only member does not receive every unit");
+      expect(p.conserved(), "maximum accumulator is not conserved");
+   }
+
+   // Equal shares split evenly, uneven shares leave at most one unit per member behind
+   {
+      pool p;
+      p.set_shares(1, 1);
+      p.set_shares(2, 1);
+      p.set_shares(3, 1);
+      p.credit(8);
+      const uint64_t claimed = p.claim(1) + p.claim(2) + p.claim(3);
+      expect(claimed == 6, "8 SCRAP over 3 shares does not round down to 2 each");
+      p.credit(1);
+      expect(p.claim(1) + p.claim(2) + p.claim(3) == 3, "carried fractions are not paid out once whole");
+      expect(p.unclaimed == 0, "evenly divisible total leaves unclaimed SCRAP");
+      expect(p.conserved(), "three way split is not conserved");
+   }
+
+   // Random mints, share changes and claims conserve every unit
+   auto random = test::make_random();
+   for (int trial = 0; trial < 200; ++trial) {
+      pool           p;
+      uint64_t       minted   = 0;
+      uint64_t       claimed  = 0;
+      const uint64_t accounts = 1 + random() % 30;
+      for (int step = 0; step < 3000; ++step) {
+         const uint64_t action  = random() % 10;
+         const uint64_t account = random() % accounts;
+         if (action < 5 && p.total_shares > 0) {
+            const uint64_t rewards[] = {1, 2, 4, 8, 8 * (1 + random() % 100)};
+            const uint64_t amount    = rewards[random() % 5];
+            p.credit(amount);
+            minted += amount;
+         } else if (action < 7) {
+            const uint64_t current   = p.members.count(account) ? p.members[account].shares : 0;
+            const uint64_t choices[] = {0, 1, 3, 7, 1 + random() % 1'000'000, POOL_MAX_SHARES / 64};
+            const uint64_t shares    = choices[random() % 6];
+            if (shares <= POOL_MAX_SHARES - (p.total_shares - current)) {
+               p.set_shares(account, shares);
+            }
+         } else if (p.members.count(account)) {
+            claimed += p.claim(account);
+         }
+      }
+      expect(p.conserved(), "random pool activity is not conserved");
+      expect(claimed + p.unclaimed == minted, "claimed and unclaimed SCRAP do not add up to the minted SCRAP");
+
+      // Once every member has left, only sub-unit dust per departure remains for the pool to close with
+      for (uint64_t account = 0; account < accounts; ++account) {
+         if (p.members.count(account)) {
+            p.set_shares(account, 0);
+            if (p.members.count(account)) {
+               claimed += p.claim(account);
+            }
+         }
+      }
+      expect(p.members.empty(), "members remain after leaving the pool");
+      expect(p.conserved(), "closing pool is not conserved");
+      expect(claimed + p.unclaimed == minted, "closing pool does not add up to the minted SCRAP");
+   }
+
+   return test::finish("pool_rewards");
+}
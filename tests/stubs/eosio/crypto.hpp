@@ -0,0 +1,28 @@
+#pragma once
+
+// Native stand-in for the parts of <eosio/crypto.hpp> used by drop_hasher. `sha256` records its input instead of
+// hashing it, so tests can compare the exact bytes that would be hashed on-chain.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace eosio {
+
+struct checksum256
+{
+   std::array<uint8_t, 32> bytes{};
+
+   std::array<uint8_t, 32> extract_as_byte_array() const { return bytes; }
+};
+
+inline std::string last_sha256_input;
+
+inline checksum256 sha256(const char* data, size_t length)
+{
+   last_sha256_input.assign(data, length);
+   return checksum256{};
+}
+
+} // namespace eosio
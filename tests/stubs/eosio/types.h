@@ -0,0 +1,6 @@
+#pragma once
+
+// Native stand-in for <eosio/types.h>
+
+typedef __int128          int128_t;
+typedef unsigned __int128 uint128_t;
@@ -0,0 +1,43 @@
+#pragma once
+
+// Minimal shared harness for the native tests run by `make test`
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+
+namespace test {
+
+inline int failures = 0;
+
+// Records a failed check, with the input that caused it when there is one
+inline void expect(const bool condition, const char* what, const std::optional<uint64_t> value = std::nullopt)
+{
+   if (condition) {
+      return;
+   }
+   if (value) {
+      std::printf("FAIL %s (%llu)\n", what, static_cast<unsigned long long>(*value));
+   } else {
+      std::printf("FAIL %s\n", what);
+   }
+   ++failures;
+}
+
+// Every test draws from the same fixed seed so failures are reproducible
+inline std::mt19937_64 make_random() { return std::mt19937_64(20240129); }
+
+// Reports the result of `suite` and returns the process exit code
+inline int finish(const char* suite)
+{
+   if (failures > 0) {
+      std::printf("%s: %d failures\n", suite, failures);
+      return EXIT_FAILURE;
+   }
+   std::printf("%s: all checks passed\n", suite);
+   return EXIT_SUCCESS;
+}
+
+} // namespace test